@@ -26,6 +26,12 @@
 #include <Print.h>
 #endif
 
+// opt in : burst prediction for sleeping between NMEA bursts (1Hz update rate only, see BurstScheduler.h)
+//#define USE_SCHEDULER
+#ifdef USE_SCHEDULER
+#include <BurstScheduler.h>
+#endif
+
 /*
 Examples:
 token:   0    1     2    3      4    5    6     7     8      9 10 11
@@ -126,6 +132,10 @@ public:
 
 	int8_t GPS_to_UTC_offset; // -17 (seconds - as of 1/1/16)
 
+#ifdef USE_SCHEDULER
+	BurstScheduler schedule; // learns the burst timing, so loop() can sleep between bursts
+#endif
+
 #if (TIMESYNC_ONLY == 0)
 #ifdef NO_FLOATS
 	int32_t Lat, Long, Alt, Height, Knots, Pace;
@@ -276,6 +286,9 @@ public:
 			if (t_ms - millis_ > sync_time_ms)
 			{
 				millis_ = t_ms;
+#ifdef USE_SCHEDULER
+				schedule.burst_start(t_ms);
+#endif
 			}
 			lhs_ = 0; rhs_ = 0; LR_switch = false;
 			token_ = 0; state_ = 0; nmea_index = 0;
@@ -348,6 +361,9 @@ public:
 				DIVISOR = 1;
 				break;
 			case '*':
+#ifdef USE_SCHEDULER
+				schedule.sentence_end(nmea_index, millis());
+#endif
 				nmea_index = 0;
 				new_data_ = true;
 				saveToken();
@@ -379,6 +395,14 @@ public:
 		return false;
 	}
 
+#ifdef USE_SCHEDULER
+	// true (once) when the last sentence of the epoch has been parsed
+	boolean epoch_complete() { return schedule.epoch_complete(); }
+
+	// how long it is safe to sleep before the next burst is due (ms). 0 => keep polling the UART
+	uint16_t ms_until_next_burst() { return schedule.ms_until_next_burst(millis()); }
+#endif
+
 private:
 	void saveToken()
 	{
@@ -0,0 +1,114 @@
+#ifndef BurstScheduler_h
+#define BurstScheduler_h
+
+#include <Arduino.h>
+
+/*
+Learns when the GPS sends its burst of NMEA sentences each epoch (1Hz by default), so the MCU can sleep
+between bursts instead of polling the UART.
+
+ATtinyGPS::parse() feeds it the start of each burst and the end of each sentence (opt in : #define USE_SCHEDULER
+before including ATtinyGPS.h). Once every sentence in `expected` has been seen the epoch is complete, and
+ms_until_next_burst() says how long it is safe to sleep.
+
+1Hz only : ATtinyGPS only starts a new burst on a '$' more than sync_time_ms (800ms) after the last one, so at
+faster update rates every other burst (or all but the first) is folded into the one before it.
+
+Times are kept as x16 fixed point internally so the running averages dont stall on integer truncation.
+*/
+
+#define NMEA_BIT(nmea_index) (1 << (nmea_index))
+
+class BurstScheduler
+{
+private:
+	uint32_t start_ms_ = 0; // start of the current burst
+	uint16_t period_x16_ = 1000 << 4;
+	uint16_t length_x16_ = 0;
+	uint16_t jitter_x16_ = 0;
+	uint8_t seen_ = 0; // NMEA_BIT(nmea_index) of each sentence parsed in the current burst
+	uint8_t rejected_ = 0; // consecutive burst periods that didnt fit the model
+	boolean started_ = false;
+	boolean complete_ = false;
+
+	// running average : avg += (value - avg) / 2^shift, value capped at 4095ms
+	static void average(uint16_t &avg_x16, const uint32_t &value_ms, const uint8_t &shift = 2)
+	{
+		avg_x16 += ((int32_t)min(value_ms, 4095UL) * 16 - avg_x16) / (1 << shift);
+	}
+
+public:
+	uint8_t expected = NMEA_BIT(1) | NMEA_BIT(4); // RMC & GGA, as sent after ATtinyGPS::setup()
+	uint8_t guard_ms = 10; // wake this much earlier than the (jitter adjusted) predicted burst start
+
+	uint16_t period_ms() { return period_x16_ >> 4; } // burst start -> next burst start
+	uint16_t length_ms() { return length_x16_ >> 4; } // burst start -> end of the last expected sentence
+	uint16_t jitter_ms() { return jitter_x16_ >> 4; } // mean deviation of the burst start from the prediction
+
+	void burst_start(const uint32_t &t_ms)
+	{
+		if (started_)
+		{
+			const uint32_t measured = t_ms - start_ms_;
+			const uint16_t period = period_ms();
+			const uint32_t deviation = (measured > period) ? measured - period : period - measured;
+
+			if (deviation < period / 4)
+			{
+				average(period_x16_, measured);
+				// the jitter rises quickly but decays slowly, so a run of quiet bursts doesnt shrink the wake margin
+				average(jitter_x16_, deviation, ((deviation << 4) > jitter_x16_) ? 2 : 4);
+				rejected_ = 0;
+			}
+			// a missed burst is skipped, but if the rate really has changed start again from what we see
+			else if (++rejected_ > 3)
+			{
+				period_x16_ = min(measured, 4095UL) << 4;
+				jitter_x16_ = 0;
+				rejected_ = 0;
+			}
+		}
+		start_ms_ = t_ms;
+		seen_ = 0;
+		started_ = true;
+		complete_ = false;
+	}
+
+	void sentence_end(const uint8_t &nmea_index, const uint32_t &t_ms)
+	{
+		if (!started_ || ((seen_ & expected) == expected)) { return; } // ignore anything after the epoch is complete
+
+		seen_ |= NMEA_BIT(nmea_index);
+		if ((seen_ & expected) == expected)
+		{
+			average(length_x16_, t_ms - start_ms_);
+			complete_ = true;
+		}
+	}
+
+	// true (once) when the last expected sentence of the epoch has been parsed
+	boolean epoch_complete()
+	{
+		if (complete_)
+		{
+			complete_ = false;
+			return true;
+		}
+		return false;
+	}
+
+	// ms until the next burst is due, less 4x the jitter (~3 standard deviations) and guard_ms.
+	// 0 => stay awake, which includes the rest of the current burst until every expected sentence is in
+	uint16_t ms_until_next_burst(const uint32_t &now_ms)
+	{
+		if (!started_ || ((seen_ & expected) != expected)) { return 0; }
+
+		const uint32_t elapsed = now_ms - start_ms_;
+		const uint16_t margin = (jitter_x16_ >> 2) + guard_ms;
+		const uint16_t period = period_ms();
+		if ((period <= margin) || (elapsed >= (uint32_t)(period - margin))) { return 0; }
+		return period - margin - elapsed;
+	}
+};
+
+#endif
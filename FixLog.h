@@ -0,0 +1,339 @@
+#ifndef FixLog_h
+#define FixLog_h
+
+// No Arduino includes here, so the same header decodes logs on the host (see extras/FixLogDump)
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Compact binary fix log
+
+Each published fix is stored as a single record. The first byte of a record is a tag:
+
+tag bit  field        keyframe (bit 7 set)       delta (bit 7 clear, only fields with their bit set follow)
+   0     Time         varint, seconds since 2000 varint, seconds since the last fix (bit clear => +1s)
+   1     Lat          zigzag varint              zigzag varint, change since the last fix
+   2     Long         zigzag varint              zigzag varint, change since the last fix
+   3     Alt          zigzag varint              zigzag varint, change since the last fix
+   4     Knots        zigzag varint              zigzag varint, change since the last fix
+   5     quality      1 byte                     1 byte
+   6     satellites   1 byte                     1 byte
+   7     keyframe     all of the above follow, in order
+
+varint : 7 bits per byte, least significant group first, bit 7 set => more bytes follow
+zigzag : 0, -1, 1, -2, 2 ... => 0, 1, 2, 3, 4 ... so small changes of either sign stay small
+
+A stationary 1Hz fix costs 1 byte, a moving one typically 4-8 bytes (vs. ~140 chars of RMC + GGA).
+Keyframes are written every FIXLOG_KEYFRAME_INTERVAL records, and whenever time goes backwards,
+so a reader can start decoding at any keyframe.
+*/
+
+#ifndef FIXLOG_KEYFRAME_INTERVAL
+#define FIXLOG_KEYFRAME_INTERVAL 60 // once a minute at 1Hz
+#endif
+
+#define FIXLOG_KEYFRAME 0x80
+#define FIXLOG_MAX_RECORD 28 // tag + 5 x 5 byte varints + quality + satellites
+
+// Lat, Long are always NMEA ddmm.mmmmm x FIXLOG_LATLONG_SCALE, whatever the build (NO_FLOATS or not),
+// so a reader never has to know how the logger was compiled
+#define FIXLOG_LATLONG_SCALE 100000L
+
+struct FixRecord
+{
+	uint32_t Time; // seconds since 00:00:00 on 01/Jan/2000
+	int32_t Lat, Long; // ddmm.mmmmm x FIXLOG_LATLONG_SCALE
+	int32_t Alt; // cm
+	int32_t Knots; // Knots x 100
+	uint8_t quality;
+	uint8_t satellites;
+};
+
+inline uint32_t zigzag_encode(const int32_t &n) { return ((uint32_t)n << 1) ^ (uint32_t)(n >> 31); }
+inline int32_t zigzag_decode(const uint32_t &n) { return (int32_t)(n >> 1) ^ -(int32_t)(n & 1); }
+
+// returns the number of bytes written (1 -> 5)
+inline uint8_t varint_write(uint32_t n, uint8_t *buf)
+{
+	uint8_t len = 0;
+	while (n > 0x7F)
+	{
+		buf[len++] = (n & 0x7F) | 0x80;
+		n >>= 7;
+	}
+	buf[len++] = n;
+	return len;
+}
+
+// returns false if the varint runs past end, or is longer than 5 bytes
+inline bool varint_read(const uint8_t *&buf, const uint8_t *end, uint32_t &n)
+{
+	n = 0;
+	for (uint8_t shift = 0; (shift < 35) & (buf < end); shift += 7)
+	{
+		const uint8_t b = *buf++;
+		n |= (uint32_t)(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) { return true; }
+	}
+	return false;
+}
+
+class FixLogWriter
+{
+private:
+	FixRecord prev_ = FixRecord();
+	uint8_t since_keyframe_ = 0; // 0 => the next record is a keyframe
+	uint8_t keyframe_interval_;
+
+	uint8_t writeField(const int32_t &curr, const int32_t &prev, const uint8_t bit, uint8_t &tag, uint8_t *buf)
+	{
+		if (curr == prev) { return 0; }
+		tag |= bit;
+		return varint_write(zigzag_encode((uint32_t)curr - (uint32_t)prev), buf);
+	}
+
+public:
+	FixLogWriter(const uint8_t keyframe_interval = FIXLOG_KEYFRAME_INTERVAL) : keyframe_interval_(keyframe_interval) {}
+
+	// Force the next record to be a keyframe (e.g. when starting a new file or EEPROM page)
+	void keyframe() { since_keyframe_ = 0; }
+
+	// Encodes fix into buf (at least FIXLOG_MAX_RECORD bytes) and returns the record length
+	uint8_t encode(const FixRecord &fix, uint8_t *buf)
+	{
+		uint8_t len = 1;
+		uint8_t tag = 0;
+
+		if ((since_keyframe_ == 0) || (fix.Time < prev_.Time))
+		{
+			tag = 0x7F | FIXLOG_KEYFRAME;
+			len += varint_write(fix.Time, buf + len);
+			len += varint_write(zigzag_encode(fix.Lat), buf + len);
+			len += varint_write(zigzag_encode(fix.Long), buf + len);
+			len += varint_write(zigzag_encode(fix.Alt), buf + len);
+			len += varint_write(zigzag_encode(fix.Knots), buf + len);
+			buf[len++] = fix.quality;
+			buf[len++] = fix.satellites;
+			since_keyframe_ = 0;
+		}
+		else
+		{
+			if (fix.Time - prev_.Time != 1)
+			{
+				tag |= 0x01;
+				len += varint_write(fix.Time - prev_.Time, buf + len);
+			}
+			len += writeField(fix.Lat, prev_.Lat, 0x02, tag, buf + len);
+			len += writeField(fix.Long, prev_.Long, 0x04, tag, buf + len);
+			len += writeField(fix.Alt, prev_.Alt, 0x08, tag, buf + len);
+			len += writeField(fix.Knots, prev_.Knots, 0x10, tag, buf + len);
+			if (fix.quality != prev_.quality) { tag |= 0x20; buf[len++] = fix.quality; }
+			if (fix.satellites != prev_.satellites) { tag |= 0x40; buf[len++] = fix.satellites; }
+		}
+		buf[0] = tag;
+		prev_ = fix;
+
+		if (++since_keyframe_ >= keyframe_interval_) { since_keyframe_ = 0; }
+
+		return len;
+	}
+};
+
+// One entry per keyframe, used to seek by time
+struct FixLogIndex
+{
+	uint32_t Time; // of the keyframe
+	uint32_t Last; // of the last record before the next keyframe (time never goes backwards in between)
+	uint32_t offset;
+};
+
+// Decodes a log held in memory (a buffer on the MCU, or an mmap'd file on the host)
+class FixLogReader
+{
+private:
+	const uint8_t *data_;
+	size_t length_;
+	size_t pos_ = 0;
+	FixRecord prev_ = FixRecord();
+	bool synced_ = false; // a delta can only be decoded after a keyframe
+
+	// Decodes from the keyframe at offset to the first record at or after Time, and leaves the reader on it
+	bool seekFrom(const size_t &offset, const uint32_t &Time, FixRecord &fix)
+	{
+		pos_ = offset;
+		synced_ = false;
+
+		size_t at = pos_;
+		FixRecord before = prev_;
+		while (next(fix))
+		{
+			if (fix.Time >= Time)
+			{
+				// leave the reader positioned on this record, so next() returns it again
+				pos_ = at;
+				prev_ = before;
+				synced_ = (data_[at] & FIXLOG_KEYFRAME) == 0;
+				return true;
+			}
+			at = pos_;
+			before = fix;
+		}
+		return false;
+	}
+
+	bool readField(const uint8_t *&p, const uint8_t *end, const uint8_t tag, const uint8_t bit, int32_t &field)
+	{
+		if ((tag & bit) == 0) { return true; }
+		uint32_t n;
+		if (!varint_read(p, end, n)) { return false; }
+		field = (uint32_t)field + (uint32_t)zigzag_decode(n);
+		return true;
+	}
+
+public:
+	FixLogReader(const uint8_t *data, const size_t length) : data_(data), length_(length) {}
+
+	size_t position() const { return pos_; }
+	void rewind() { pos_ = 0; synced_ = false; }
+
+	// Decodes the record at the current position. Returns false at the end of the log, or if the
+	// record is truncated (e.g. power was lost mid-write); the position is then left unchanged
+	bool next(FixRecord &fix)
+	{
+		const uint8_t *p = data_ + pos_;
+		const uint8_t *end = data_ + length_;
+		if (p >= end) { return false; }
+
+		const uint8_t tag = *p++;
+		FixRecord curr = prev_;
+		uint32_t n;
+
+		if (tag & FIXLOG_KEYFRAME)
+		{
+			if (!varint_read(p, end, curr.Time)) { return false; }
+			if (!varint_read(p, end, n)) { return false; } curr.Lat = zigzag_decode(n);
+			if (!varint_read(p, end, n)) { return false; } curr.Long = zigzag_decode(n);
+			if (!varint_read(p, end, n)) { return false; } curr.Alt = zigzag_decode(n);
+			if (!varint_read(p, end, n)) { return false; } curr.Knots = zigzag_decode(n);
+			if (end - p < 2) { return false; }
+			curr.quality = *p++;
+			curr.satellites = *p++;
+		}
+		else
+		{
+			if (!synced_) { return false; }
+			n = 1;
+			if ((tag & 0x01) && !varint_read(p, end, n)) { return false; }
+			curr.Time += n;
+			if (!readField(p, end, tag, 0x02, curr.Lat)) { return false; }
+			if (!readField(p, end, tag, 0x04, curr.Long)) { return false; }
+			if (!readField(p, end, tag, 0x08, curr.Alt)) { return false; }
+			if (!readField(p, end, tag, 0x10, curr.Knots)) { return false; }
+			if (tag & 0x20) { if (p >= end) { return false; } curr.quality = *p++; }
+			if (tag & 0x40) { if (p >= end) { return false; } curr.satellites = *p++; }
+		}
+
+		pos_ = p - data_;
+		synced_ = true;
+		prev_ = curr;
+		fix = curr;
+		return true;
+	}
+
+	// Scans the whole log and fills index with up to max keyframes.
+	// Returns the number of keyframes found (call with max = 0 to size the index first)
+	size_t buildIndex(FixLogIndex *index, const size_t max)
+	{
+		size_t count = 0;
+		FixRecord fix;
+		rewind();
+		for (size_t offset = pos_; next(fix); offset = pos_)
+		{
+			if (data_[offset] & FIXLOG_KEYFRAME)
+			{
+				if (count < max)
+				{
+					index[count].Time = fix.Time;
+					index[count].offset = offset;
+				}
+				++count;
+			}
+			if (count <= max) { index[count - 1].Last = fix.Time; }
+		}
+		rewind();
+		return count;
+	}
+
+	// Positions the reader on the first record at or after Time and decodes it into fix, using the index from
+	// buildIndex(). Returns false if there is no such record.
+	// Time only goes backwards at a keyframe (e.g. logging started on a GGA, before an RMC set the date), which
+	// splits the log into runs where it only increases. Every run is searched, and the record closest to Time
+	// wins (the earliest in the log on a tie), so a run of bad times doesnt hide the fixes after it
+	bool seek(const FixLogIndex *index, const size_t count, const uint32_t Time, FixRecord &fix)
+	{
+		bool found = false;
+		size_t best = 0;
+		for (size_t run = 0, end; run < count; run = end)
+		{
+			// the run ends where time steps back
+			end = run + 1;
+			while ((end < count) && (index[end].Time >= index[end - 1].Last)) { ++end; }
+
+			// binary search the run for the first keyframe whose records reach Time
+			size_t lo = run, hi = end;
+			while (lo < hi)
+			{
+				const size_t mid = lo + (hi - lo) / 2;
+				if (index[mid].Last < Time) { lo = mid + 1; }
+				else { hi = mid; }
+			}
+			if ((lo == end) || (found && (index[lo].Time >= fix.Time))) { continue; }
+
+			FixRecord candidate;
+			if (seekFrom(index[lo].offset, Time, candidate) && (!found || (candidate.Time < fix.Time)))
+			{
+				found = true;
+				best = lo;
+				fix = candidate;
+			}
+		}
+		return found && seekFrom(index[best].offset, Time, fix);
+	}
+};
+
+// v * to / from, rounded towards zero, without overflowing 32 bits
+inline int32_t fixlog_rescale(const int32_t &v, uint32_t from, const uint32_t &to)
+{
+	const uint32_t a = (v < 0) ? -v : v;
+	const uint32_t whole = (a / from) * to;
+	uint32_t part = a % from;
+	// keep part * to in 32 bits, giving up the low bits of part (and from) if needed
+	while (part > 0xFFFFFFFFUL / to) { part >>= 1; from >>= 1; }
+	const uint32_t r = whole + part * to / from;
+	return (v < 0) ? -(int32_t)r : r;
+}
+
+#if defined(ATtinyGPS_h) && (TIMESYNC_ONLY == 0)
+// Include after ATtinyGPS.h to log straight from the parser.
+// Note: Time is local time, i.e. it includes the timezone and GPS_to_UTC_offset
+inline void toFixRecord(const ATtinyGPS &gps, FixRecord &fix)
+{
+	fix.Time = to_seconds_since_2000<uint8_t>(gps.hh, gps.mm, gps.ss, gps.DD, gps.MM, gps.YY);
+#ifdef NO_FLOATS
+	// the parser holds ddmm.mmmm x LATLONG_DIVISOR
+	fix.Lat = fixlog_rescale(gps.Lat, LATLONG_DIVISOR, FIXLOG_LATLONG_SCALE);
+	fix.Long = fixlog_rescale(gps.Long, LATLONG_DIVISOR, FIXLOG_LATLONG_SCALE);
+	fix.Alt = gps.Alt;
+	fix.Knots = gps.Knots;
+#else
+	fix.Lat = gps.Lat * FIXLOG_LATLONG_SCALE + ((gps.Lat < 0) ? -0.5f : 0.5f);
+	fix.Long = gps.Long * FIXLOG_LATLONG_SCALE + ((gps.Long < 0) ? -0.5f : 0.5f);
+	fix.Alt = gps.Alt + ((gps.Alt < 0) ? -0.5f : 0.5f); // already in cm
+	fix.Knots = gps.Knots * 100 + 0.5f;
+#endif
+	fix.quality = gps.quality;
+	fix.satellites = gps.satellites;
+}
+#endif
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef GeoTools_h
+#define GeoTools_h
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+/*
+Float free geodesy : distance, bearing and an odometer in fixed point (no sin/cos/sqrt from libm)
+
+Angles are in microdegrees (udeg, int32_t), distances in cm, bearings in centidegrees (0 -> 35999).
+1 udeg of latitude is ~11.12cm (mean earth radius 6371.0088km)
+
+Checked on the host against a double precision haversine / initial bearing by extras/GeoToolsCheck
+(500k random pairs per band, |lat| < 80 deg):
+- distance, legs < 20m                         : < 1cm
+- distance, legs 20m -> 19,000km               : < 0.03%
+- distance, near antipodal legs (> 19,000km)   : < 0.5km
+- bearing, legs < 10km                         : < 0.03 deg
+The worst case for short legs is near the poles, where the Q15 cos(latitude) has the fewest significant bits.
+The equirectangular error grows with the leg (and the latitude) while the haversine's shrinks, so
+EQUIRECTANGULAR_LIMIT_UDEG is where the two measured worst cases meet (~0.028% at 0.4 deg)
+*/
+
+#define UDEG_PER_DEGREE 1000000L
+#ifndef EQUIRECTANGULAR_LIMIT_UDEG
+#define EQUIRECTANGULAR_LIMIT_UDEG 400000L // use the haversine for legs of 0.4 degrees (~44km) or more
+#endif
+
+// cos(degree) in Q15 (32768 = 1.0), 0 -> 90 degrees
+const uint16_t COS_Q15[91] PROGMEM = {
+	32768, 32763, 32748, 32723, 32688, 32643, 32588, 32524, 32449, 32365,
+	32270, 32166, 32052, 31928, 31795, 31651, 31499, 31336, 31164, 30983,
+	30792, 30592, 30382, 30163, 29935, 29698, 29452, 29197, 28932, 28660,
+	28378, 28088, 27789, 27482, 27166, 26842, 26510, 26170, 25822, 25466,
+	25102, 24730, 24351, 23965, 23571, 23170, 22763, 22348, 21926, 21498,
+	21063, 20622, 20174, 19720, 19261, 18795, 18324, 17847, 17364, 16877,
+	16384, 15886, 15384, 14876, 14365, 13848, 13328, 12803, 12275, 11743,
+	11207, 10668, 10126,  9580,  9032,  8481,  7927,  7371,  6813,  6252,
+	 5690,  5126,  4560,  3993,  3425,  2856,  2286,  1715,  1144,   572,
+	    0 };
+
+#define cos_q15_table(k) pgm_read_word_near(COS_Q15 + k)
+
+// Converts an NMEA ddmm.mmmm value held as fixed point (ddmm.mmmm * scale) to microdegrees.
+// e.g. NO_FLOATS : ddmm_to_udeg(gps.Lat, LATLONG_DIVISOR) (LATLONG_DIVISOR is a uint16_t, so it holds 16960 not 1000000)
+//      floats    : ddmm_to_udeg(gps.Lat * 1000, 1000)
+// Any scale up to 42949672 is fine; scales above 85899 give up their low bits to stay in 32 bits
+inline int32_t ddmm_to_udeg(const int32_t &ddmm, const uint32_t &scale)
+{
+	const uint32_t v = (ddmm < 0) ? -ddmm : ddmm;
+	const uint32_t degrees = v / (100 * scale);
+	const uint32_t mins = v % (100 * scale); // minutes * scale
+
+	// 1 minute = 1000000/60 = 50000/3 udeg. part * 50000 must fit in 32 bits
+	uint32_t part = mins % scale;
+	uint32_t s = scale;
+	while (s > 85899) { part >>= 1; s >>= 1; }
+
+	const uint32_t udeg = degrees * UDEG_PER_DEGREE + ((mins / scale) * 50000 + part * 50000 / s) / 3;
+	return (ddmm < 0) ? -(int32_t)udeg : udeg;
+}
+
+// cos(angle) in Q15, angle in udeg (any sign, |angle| < 2147 degrees)
+inline int32_t cos_udeg(int32_t angle)
+{
+	if (angle < 0) { angle = -angle; }
+	angle %= 360 * UDEG_PER_DEGREE;
+	if (angle > 180 * UDEG_PER_DEGREE) { angle = 360 * UDEG_PER_DEGREE - angle; }
+
+	int8_t sign = 1;
+	if (angle > 90 * UDEG_PER_DEGREE) { angle = 180 * UDEG_PER_DEGREE - angle; sign = -1; }
+
+	const uint8_t idx = angle / UDEG_PER_DEGREE;
+	const uint32_t frac = angle % UDEG_PER_DEGREE;
+	int32_t c = cos_q15_table(idx);
+	if (frac > 0)
+	{
+		// cos(x + d) = cos(x).cos(d) - sin(x).sin(d), with cos(d) ~ 1 - d^2/2 and sin(d) ~ d as d < 1 degree.
+		// Worked in Q30 and rounded once at the end, so only the table's own rounding is left
+		const int32_t d = (frac * 2399UL) >> 17; // radians, Q20 (2399/2^37 ~ pi/180e6)
+		const int32_t s = cos_q15_table(90 - idx); // sin(x)
+		c = ((c << 15) - ((c * ((d * d) >> 20)) >> 6) - ((s * d) >> 5) + (1L << 14)) >> 15;
+	}
+	return sign * c;
+}
+
+// sin(angle) in Q15, angle in udeg
+inline int32_t sin_udeg(const int32_t &angle)
+{
+	return cos_udeg(angle - 90 * UDEG_PER_DEGREE);
+}
+
+// a * b / 2^30 for a, b < 2^31, split into 15 bit halves so nothing overflows
+inline uint32_t mul_q30(const uint32_t &a, const uint32_t &b)
+{
+	const uint32_t ah = a >> 15, al = a & 0x7FFF;
+	const uint32_t bh = b >> 15, bl = b & 0x7FFF;
+	return ah * bh + ((ah * bl) >> 15) + ((al * bh) >> 15) + ((al * bl) >> 30);
+}
+
+// sin(angle) in Q30. Angles under 10 degrees use the series x - x^3/6 + x^5/120, so small angles keep
+// their relative precision (a Q15 table value of sin(1 degree) is only good to ~0.1%)
+inline int32_t sin_q30(const int32_t &angle)
+{
+	const uint32_t a = (angle < 0) ? -angle : angle;
+	if (a > 10 * UDEG_PER_DEGREE) { return sin_udeg(angle) * 32768; }
+
+	// radians in Q30 = udeg * 18.740330 (split so a * 48519 doesnt overflow)
+	const uint32_t x = a * 18 + (((a >> 10) * 48519) >> 6) + (((a & 1023) * 48519) >> 16);
+	const uint32_t x2 = mul_q30(x, x);
+	const uint32_t t3 = mul_q30(x, x2) / 6;
+	const uint32_t t5 = mul_q30(t3, x2) / 20;
+	const int32_t s = x - t3 + t5;
+	return (angle < 0) ? -s : s;
+}
+
+// asin(h) in udeg, where h is sqrt(a) in Q(15 + k) and a is in Q30, for angles up to 45 degrees
+inline uint32_t asin_udeg(const uint16_t &h, const uint32_t &a, const uint8_t &k)
+{
+	// under 10 degrees : asin(h) = h + h^3/6 + 3h^5/40 (and h^2 == a)
+	if (a <= 32377154UL) // sin^2(10 degrees)
+	{
+		// h * 180e6/pi / 2^16 = h * 874.2642, then down to Q(15 + k)
+		uint32_t udeg = ((h * 874UL + ((h * 271UL) >> 10)) + (1UL << (k - 2))) >> (k - 1);
+		const uint32_t a2 = (a >> 15) * (a >> 15);
+		udeg += ((udeg >> 8) * (a >> 10) / 6) >> 12;
+		udeg += ((udeg >> 8) * (a2 >> 10) * 3 / 40) >> 12;
+		return udeg;
+	}
+
+	// otherwise search sin(degree) == cos_q15_table(90 - degree) and interpolate
+	uint8_t lo = 0, hi = 90; // sin(lo) <= h < sin(hi)
+	while (hi - lo > 1)
+	{
+		const uint8_t mid = (lo + hi) >> 1;
+		if (((uint32_t)cos_q15_table(90 - mid) << k) <= h) { lo = mid; }
+		else { hi = mid; }
+	}
+	const uint32_t s_lo = (uint32_t)cos_q15_table(90 - lo) << k;
+	const uint32_t s_hi = (uint32_t)cos_q15_table(90 - hi) << k;
+	return lo * UDEG_PER_DEGREE + (h - s_lo) * 250000 / (s_hi - s_lo) * 4;
+}
+
+// floor(sqrt(n))
+inline uint16_t isqrt(uint32_t n)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+	while (bit > n) { bit >>= 2; }
+	while (bit != 0)
+	{
+		if (n >= root + bit)
+		{
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+// wraps a longitude difference into +-180 degrees
+inline int32_t wrap_udeg(int32_t angle)
+{
+	if (angle > 180 * UDEG_PER_DEGREE) { angle -= 360 * UDEG_PER_DEGREE; }
+	else if (angle < -180 * UDEG_PER_DEGREE) { angle += 360 * UDEG_PER_DEGREE; }
+	return angle;
+}
+
+// Scales dx, dy so the larger of the two is in [2^14, 2^15), and returns the number of bits
+// they were shifted left (-ve => right). Keeps dx^2 + dy^2 in 31 bits at full precision
+inline int8_t normalise_q15(int32_t &dx, int32_t &dy)
+{
+	int8_t shift = 0;
+	uint32_t m = max((dx < 0) ? -dx : dx, (dy < 0) ? -dy : dy);
+	if (m == 0) { return 0; }
+	while (m >= 32768) { m >>= 1; --shift; }
+	while (m < 16384) { m <<= 1; ++shift; }
+	if (shift < 0) { dx >>= -shift; dy >>= -shift; }
+	else { dx *= 1L << shift; dy *= 1L << shift; }
+	return shift;
+}
+
+// Flat earth offsets from point 1 to point 2 (dx scaled by the cosine of the mean latitude), normalised
+// with normalise_q15 so short legs keep their precision. Returns the normalising shift
+inline int8_t local_xy(const int32_t &lat1, const int32_t &lon1, const int32_t &lat2, const int32_t &lon2, int32_t &dx, int32_t &dy)
+{
+	dy = lat2 - lat1;
+	dx = wrap_udeg(lon2 - lon1);
+	const int8_t shift = normalise_q15(dx, dy);
+
+	// scale in Q30 and normalise again, else dx keeps only ~12 bits near the poles (cos(80 deg) ~ 0.17)
+	dx *= cos_udeg(lat1 / 2 + lat2 / 2);
+	dy *= 1L << 15;
+	return shift + normalise_q15(dx, dy) + 15;
+}
+
+// haversine : a = sin^2(dlat/2) + cos(lat1).cos(lat2).sin^2(dlon/2), in Q30
+inline uint32_t haversine_q30(const int32_t &lat1, const int32_t &lon1, const int32_t &lat2, const int32_t &lon2)
+{
+	const uint32_t s_lat = abs(sin_q30((lat2 - lat1) / 2));
+	const uint32_t s_lon = abs(sin_q30(wrap_udeg(lon2 - lon1) / 2));
+	const uint32_t cos_cos = cos_udeg(lat1) * cos_udeg(lat2); // Q30, +ve as |lat| <= 90
+	const uint32_t a = mul_q30(s_lat, s_lat) + mul_q30(cos_cos, mul_q30(s_lon, s_lon));
+	return min(a, 1UL << 30);
+}
+
+// Great circle angle between two points in udeg
+inline uint32_t central_angle_udeg(const int32_t &lat1, const int32_t &lon1, const int32_t &lat2, const int32_t &lon2)
+{
+	uint32_t a = haversine_q30(lat1, lon1, lat2, lon2);
+
+	// past 90 degrees, asin(sqrt(a)) is badly conditioned. Measure to the antipode of point 2 instead
+	const bool far = a > (1UL << 29);
+	if (far) { a = haversine_q30(lat1, lon1, -lat2, lon2 + 180 * UDEG_PER_DEGREE); }
+	if (a == 0) { return far ? 180 * UDEG_PER_DEGREE : 0; }
+
+	// take sqrt(a) with as many bits as fit in 32 : h is Q(15 + k)
+	uint8_t k = 1;
+	while ((k < 15) && (a < (1UL << (30 - 2 * k)))) { ++k; }
+	const uint32_t c = 2 * asin_udeg(isqrt(a << (2 * k)), a, k);
+
+	return far ? 180 * UDEG_PER_DEGREE - c : c;
+}
+
+// Distance between two points in cm
+// Equirectangular for legs under EQUIRECTANGULAR_LIMIT_UDEG (i.e. between fixes), haversine otherwise
+inline uint32_t distance_cm(const int32_t &lat1, const int32_t &lon1, const int32_t &lat2, const int32_t &lon2)
+{
+	int32_t dx, dy;
+	const int8_t shift = local_xy(lat1, lon1, lat2, lon2, dx, dy);
+	const uint32_t m = max(abs(dx), abs(dy));
+
+	if ((shift >= 0) || ((m << -shift) < EQUIRECTANGULAR_LIMIT_UDEG))
+	{
+		const uint32_t d = isqrt(dx * dx + dy * dy);
+
+		// 11.11951 cm per udeg = 91091 / 2^13, rounded (not truncated) so an odometer doesnt drift low
+		const int8_t out_shift = 13 + shift;
+		return (out_shift > 0) ? (d * 91091UL + (1UL << (out_shift - 1))) >> out_shift : (d * 91091UL) << -out_shift;
+	}
+
+	const uint32_t c = central_angle_udeg(lat1, lon1, lat2, lon2);
+	return c * 11 + (((c >> 10) * 1958) >> 4);
+}
+
+// Bearing from point 1 to point 2 in centidegrees (0 = North, 9000 = East)
+// Flat earth, corrected for the convergence of the meridians, so it is intended for the short legs between fixes
+inline uint16_t bearing_cdeg(const int32_t &lat1, const int32_t &lon1, const int32_t &lat2, const int32_t &lon2)
+{
+	int32_t dx, dy;
+	local_xy(lat1, lon1, lat2, lon2, dx, dy);
+	if ((dx == 0) & (dy == 0)) { return 0; }
+
+	const uint32_t ax = abs(dx);
+	const uint32_t ay = abs(dy);
+	const bool swap = ax > ay;
+
+	// atan(z) for z in [0,1] : minimax polynomial in z^2 (error ~1e-5 rad), coefficients in Q15
+	const int32_t z = swap ? (ay << 15) / ax : (ax << 15) / ay;
+	const int32_t z2 = (z * z) >> 15;
+	int32_t p = 683;
+	p = -2790 + ((p * z2) >> 15);
+	p = 5903 + ((p * z2) >> 15);
+	p = -10823 + ((p * z2) >> 15);
+	p = 32764 + ((p * z2) >> 15);
+	int32_t angle = (((z * p) >> 15) * 11459 + (1L << 15)) >> 16; // radians (Q15) to centidegrees
+	if (swap) { angle = 9000 - angle; } // angle from North
+
+	if (dy < 0) { angle = 18000 - angle; }
+	if (dx < 0) { angle = 36000 - angle; }
+
+	// the flat earth gives the bearing at the middle of the leg, the start is dlon.sin(lat)/2 further round
+	const int32_t dlon_cdeg = wrap_udeg(lon2 - lon1) / 10000;
+	angle -= (dlon_cdeg * sin_udeg(lat1 / 2 + lat2 / 2)) >> 16;
+
+	if (angle < 0) { angle += 36000; }
+	else if (angle >= 36000) { angle -= 36000; }
+	return angle;
+}
+
+// Accumulates distance travelled between fixes, and the average pace over that distance
+class Odometer
+{
+private:
+	int32_t lat_, lon_;
+	uint32_t start_time_ = 0, time_ = 0;
+	boolean started_ = false;
+
+public:
+	uint32_t Distance = 0; // total distance travelled, cm
+	uint16_t Bearing = 0; // bearing of the last leg, centidegrees
+	uint16_t min_step_cm; // legs shorter than this are treated as GPS jitter and held over
+
+	Odometer(const uint16_t _min_step_cm = 0) : min_step_cm(_min_step_cm) {}
+
+	void reset() { started_ = false; Distance = 0; Bearing = 0; }
+
+	// lat, lon in udeg. Time in seconds that dont wrap at midnight, i.e. to_seconds_since_2000()
+	void update(const int32_t &lat, const int32_t &lon, const uint32_t &Time)
+	{
+		time_ = Time;
+		if (!started_)
+		{
+			lat_ = lat; lon_ = lon;
+			start_time_ = Time;
+			started_ = true;
+			return;
+		}
+
+		const uint32_t d = distance_cm(lat_, lon_, lat, lon);
+		// while below the threshold the start of the leg is kept, so slow movement still adds up
+		if (d < min_step_cm) { return; }
+
+		Distance += d;
+		Bearing = bearing_cdeg(lat_, lon_, lat, lon);
+		lat_ = lat; lon_ = lon;
+	}
+
+	uint32_t elapsed() { return time_ - start_time_; } // seconds
+
+	// average pace in secs/km (same units as ATtinyGPS Pace with NO_FLOATS), 0 if we havent moved
+	uint32_t pace()
+	{
+		const uint32_t metres = Distance / 100;
+		return (metres == 0) ? 0 : elapsed() * 1000 / metres;
+	}
+};
+
+#endif
@@ -141,6 +141,17 @@ void from_day_of_the_year(const uint16_t &doty, T &_DD, T &_MM, const bool &_is_
 	_MM = 0;
 }
 
+// seconds since 00:00:00 on 01/Jan/2000 (good until 2100, as 2100 is not a leap year)
+template <typename T>
+uint32_t to_seconds_since_2000(const T &_hour, const T &_mins, const T &_secs, const T &_DD, const T &_MM, const T &_YY)
+{
+	// leap days in the years before this one (2000 was a leap year)
+	uint16_t days = (uint16_t)_YY * 365 + (_YY + 3) / 4;
+	days += to_day_of_the_year<T>(_DD, _MM, is_leap_year(2000 + _YY)) - 1;
+
+	return days * 86400UL + _hour * 3600UL + _mins * 60UL + _secs;
+}
+
 // example: input = day (unbounded), TD0 = day (bounded), TD1 = month (bounded), prevMax = days in last month, currMax = days in this month
 // timeDateCompensate(-1, day, month, 1, 28, 31) => day = 27, month = month - 1
 // timeDateCompensate( 0, day, month, 1, 28, 31) => day = 28, month = month - 1
@@ -0,0 +1,153 @@
+/*
+Host simulation of BurstScheduler.h, driven through ATtinyGPS::parse() (Linux/macOS)
+
+Build : g++ -O2 -I../.. -I../HostShim -o burst_scheduler_check burst_scheduler_check.cpp
+Usage : burst_scheduler_check
+
+Feeds RMC & GGA bursts at 9600 baud off a simulated clock, and checks
+- ms_until_next_burst() is 0 until the epoch is complete (i.e. never mid-burst)
+- with the burst start jittered (sd 1, 4, 10ms) a sleep of ms_until_next_burst() never wakes after the next burst starts
+- a dropped epoch doesnt disturb the learnt period
+- a rate change (1s -> 2s) is relearnt within a few bursts
+Exits with 1 if any check fails
+*/
+
+// std headers first : the Arduino min/max macros break <random>
+#include <math.h>
+#include <stdio.h>
+#include <random>
+
+#define USE_SCHEDULER
+#include <ATtinyGPS.h>
+
+static const char *BURST =
+	"$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+	"$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+static const double MS_PER_CHAR = 10000.0 / 9600; // 8N1
+
+static int failures = 0;
+
+static void check(const char *name, const bool ok, const double measured)
+{
+	printf("%-4s %-60s %8.1f\n", ok ? "ok" : "FAIL", name, measured);
+	failures += !ok;
+}
+
+struct Sim
+{
+	ATtinyGPS gps;
+	uint32_t mid_burst_sleeps = 0; // ms_until_next_burst() != 0 before the epoch was complete
+
+	// feeds one burst starting at start_ms. Returns when a sleep of ms_until_next_burst() would end (0 if never complete)
+	uint32_t burst(const double start_ms)
+	{
+		uint32_t wake_ms = 0;
+		double t = start_ms;
+		for (const char *c = BURST; *c != '\0'; ++c, t += MS_PER_CHAR)
+		{
+			host_millis = (uint32_t)t;
+			gps.parse(*c);
+			if (gps.epoch_complete())
+			{
+				wake_ms = host_millis + gps.ms_until_next_burst();
+			}
+			else if ((wake_ms == 0) && (gps.ms_until_next_burst() != 0))
+			{
+				++mid_burst_sleeps;
+			}
+		}
+		return wake_ms;
+	}
+};
+
+// bursts every period_ms with normally distributed start jitter. Counts wakes after the next burst has started
+static uint32_t late_wakes(const double jitter_sd_ms, const uint16_t epochs, double &mean_sleep_ms, uint32_t &mid_burst_sleeps)
+{
+	std::mt19937 rng(7);
+	std::normal_distribution<double> jitter(0, jitter_sd_ms);
+	Sim sim;
+	uint32_t late = 0, wake_ms = 0;
+	double slept = 0;
+
+	for (uint16_t n = 0; n < epochs; ++n)
+	{
+		const double start_ms = 5000 + n * 1000.0 + 20 + jitter(rng);
+		if ((n > 10) && (wake_ms > (uint32_t)start_ms)) { ++late; } // allow the model 10 bursts to settle
+		const uint32_t complete_ms = (uint32_t)(start_ms + strlen(BURST) * MS_PER_CHAR);
+		wake_ms = sim.burst(start_ms);
+		slept += wake_ms - complete_ms;
+	}
+	mean_sleep_ms = slept / epochs;
+	mid_burst_sleeps = sim.mid_burst_sleeps;
+	return late;
+}
+
+int main()
+{
+	// jittered starts
+	const double sds[] = { 1, 4, 10 };
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		double mean_sleep_ms;
+		uint32_t mid_burst_sleeps;
+		const uint32_t late = late_wakes(sds[i], 3000, mean_sleep_ms, mid_burst_sleeps);
+		char label[80];
+		snprintf(label, sizeof(label), "jitter sd %2.0fms : late wakes in 3000 epochs", sds[i]);
+		check(label, late == 0, late);
+		snprintf(label, sizeof(label), "jitter sd %2.0fms : sleeps while mid-burst", sds[i]);
+		check(label, mid_burst_sleeps == 0, mid_burst_sleeps);
+		snprintf(label, sizeof(label), "jitter sd %2.0fms : mean sleep per epoch (ms)", sds[i]);
+		check(label, mean_sleep_ms > 700, mean_sleep_ms);
+	}
+
+	// mid-burst : between RMC and GGA the scheduler must not offer a sleep, even once the period is learnt
+	{
+		Sim sim;
+		for (uint16_t n = 0; n < 20; ++n) { sim.burst(5000 + n * 1000.0); }
+		const char *gga = strstr(BURST, "$GPGGA");
+		double t = 25000;
+		uint32_t offered = 0;
+		for (const char *c = BURST; c != gga; ++c, t += MS_PER_CHAR)
+		{
+			host_millis = (uint32_t)t;
+			sim.gps.parse(*c);
+		}
+		offered = sim.gps.ms_until_next_burst();
+		check("mid-burst : ms_until_next_burst() after RMC, before GGA", (offered == 0) && !sim.gps.epoch_complete(), offered);
+	}
+
+	// a dropped epoch
+	{
+		Sim sim;
+		uint32_t late = 0, wake_ms = 0;
+		for (uint16_t n = 0; n < 60; ++n)
+		{
+			if (n == 30) { continue; } // the receiver missed this one (or the UART did)
+			const double start_ms = 5000 + n * 1000.0;
+			if ((n > 10) && (wake_ms > (uint32_t)start_ms)) { ++late; }
+			wake_ms = sim.burst(start_ms);
+		}
+		check("dropped epoch : learnt period (ms)", sim.gps.schedule.period_ms() == 1000, sim.gps.schedule.period_ms());
+		check("dropped epoch : late wakes", late == 0, late);
+	}
+
+	// the update rate changes from 1s to 2s, which has to be relearnt
+	{
+		Sim sim;
+		double start_ms = 5000;
+		for (uint16_t n = 0; n < 30; ++n, start_ms += 1000) { sim.burst(start_ms); }
+		uint16_t relearnt = 0;
+		uint32_t late = 0, wake_ms = 0;
+		for (uint16_t n = 1; n <= 30; ++n, start_ms += 2000)
+		{
+			if ((relearnt > 0) && (wake_ms > (uint32_t)start_ms)) { ++late; }
+			wake_ms = sim.burst(start_ms);
+			if ((relearnt == 0) && (sim.gps.schedule.period_ms() > 1900)) { relearnt = n; }
+		}
+		check("rate change : bursts until the new period is learnt", (relearnt > 0) && (relearnt <= 6), relearnt);
+		check("rate change : learnt period (ms)", abs(sim.gps.schedule.period_ms() - 2000) < 5, sim.gps.schedule.period_ms());
+		check("rate change : late wakes once relearnt", late == 0, late);
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
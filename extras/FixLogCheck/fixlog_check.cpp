@@ -0,0 +1,252 @@
+/*
+Host check of FixLog.h (Linux/macOS)
+
+Build : g++ -O2 -I../.. -I../HostShim -o fixlog_check fixlog_check.cpp
+        g++ -O2 -DNO_FLOATS -I../.. -I../HostShim -o fixlog_check_no_floats fixlog_check.cpp
+Usage : fixlog_check && fixlog_check_no_floats
+
+Checks
+- random fixes (including the int32 extremes) survive FixLogWriter -> FixLogReader, for several keyframe intervals
+- a log cut off mid-record decodes up to the last whole record, and stops there
+- a log that doesnt start with a keyframe decodes nothing
+- seek() against a linear search, on monotonic logs and on logs where time steps back
+- toFixRecord() gives the same record from the same sentences, whichever build (NO_FLOATS or not)
+Exits with 1 if any check fails
+*/
+
+// std headers first : the Arduino min/max macros break <random>
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <ATtinyGPS.h>
+#include <FixLog.h>
+
+static int failures = 0;
+
+static void check(const char *name, const bool ok)
+{
+	printf("%-4s %s\n", ok ? "ok" : "FAIL", name);
+	failures += !ok;
+}
+
+static bool same(const FixRecord &a, const FixRecord &b)
+{
+	return (a.Time == b.Time) && (a.Lat == b.Lat) && (a.Long == b.Long) && (a.Alt == b.Alt) &&
+		(a.Knots == b.Knots) && (a.quality == b.quality) && (a.satellites == b.satellites);
+}
+
+struct Log
+{
+	std::vector<FixRecord> fixes;
+	std::vector<uint8_t> data;
+	std::vector<size_t> ends; // byte offset just past each record
+
+	void write(FixLogWriter &writer, const FixRecord &fix)
+	{
+		uint8_t buf[FIXLOG_MAX_RECORD];
+		const uint8_t len = writer.encode(fix, buf);
+		data.insert(data.end(), buf, buf + len);
+		fixes.push_back(fix);
+		ends.push_back(data.size());
+	}
+};
+
+// a random walk, with the occasional jump to the int32 extremes and a long gap in time
+static Log random_log(std::mt19937 &rng, const uint8_t keyframe_interval, const uint16_t records)
+{
+	std::uniform_int_distribution<int32_t> step(-2000, 2000);
+	std::uniform_int_distribution<uint32_t> any(0, 0xFFFFFFFF);
+	std::uniform_int_distribution<uint16_t> percent(0, 99);
+	const int32_t extremes[] = { INT32_MIN, INT32_MAX, INT32_MIN + 1, INT32_MAX - 1, 0, -1 };
+
+	FixLogWriter writer(keyframe_interval);
+	Log log;
+	FixRecord fix = FixRecord();
+	fix.Time = 500000000;
+	for (uint16_t n = 0; n < records; ++n)
+	{
+		fix.Time += (percent(rng) < 2) ? any(rng) >> 8 : percent(rng) % 3; // +0..2s, or a long gap
+		int32_t *field[] = { &fix.Lat, &fix.Long, &fix.Alt, &fix.Knots };
+		for (uint8_t i = 0; i < 4; ++i)
+		{
+			if (percent(rng) < 3) { *field[i] = extremes[any(rng) % 6]; }
+			else if (percent(rng) < 50) { *field[i] = (uint32_t)*field[i] + (uint32_t)step(rng); }
+		}
+		if (percent(rng) < 5) { fix.quality = any(rng); }
+		if (percent(rng) < 10) { fix.satellites = any(rng); }
+		if (percent(rng) < 1) { writer.keyframe(); }
+		log.write(writer, fix);
+	}
+	return log;
+}
+
+// fixes at a steady 1Hz, except that time jumps by `jump` seconds (-ve => back) before record `at`
+static Log stepped_log(const uint16_t records, const uint16_t at, const int32_t jump, const uint32_t start)
+{
+	FixLogWriter writer(10);
+	Log log;
+	FixRecord fix = FixRecord();
+	fix.Time = start;
+	for (uint16_t n = 0; n < records; ++n)
+	{
+		if (n == at) { fix.Time += jump; }
+		fix.Lat += 7; fix.Long -= 3;
+		log.write(writer, fix);
+		++fix.Time;
+	}
+	return log;
+}
+
+static bool round_trip(const Log &log)
+{
+	FixLogReader reader(log.data.data(), log.data.size());
+	FixRecord fix;
+	for (size_t i = 0; i < log.fixes.size(); ++i)
+	{
+		if (!reader.next(fix) || !same(fix, log.fixes[i]) || (reader.position() != log.ends[i])) { return false; }
+	}
+	return !reader.next(fix) && (reader.position() == log.data.size());
+}
+
+// cut the log at every byte : the reader must give back the whole records, then stop at the cut one
+static bool truncated(const Log &log)
+{
+	FixRecord fix;
+	for (size_t length = 0; length < log.data.size(); ++length)
+	{
+		FixLogReader reader(log.data.data(), length);
+		size_t decoded = 0;
+		while (reader.next(fix))
+		{
+			if (!same(fix, log.fixes[decoded])) { return false; }
+			++decoded;
+		}
+		const size_t whole = (size_t)(std::upper_bound(log.ends.begin(), log.ends.end(), length) - log.ends.begin());
+		const size_t stop = (whole == 0) ? 0 : log.ends[whole - 1];
+		if ((decoded != whole) || (reader.position() != stop)) { return false; }
+	}
+	return true;
+}
+
+// seek() must find the record with the smallest Time at or after the target (the earliest on a tie),
+// and leave the reader so next() returns it, then the records after it
+static bool seek_matches(const Log &log)
+{
+	FixLogReader reader(log.data.data(), log.data.size());
+	std::vector<FixLogIndex> index(reader.buildIndex(NULL, 0));
+	reader.buildIndex(index.data(), index.size());
+
+	// every fix time, either side of it, and past the end
+	std::vector<uint32_t> targets(1, 0xFFFFFFFF);
+	for (size_t i = 0; i < log.fixes.size(); ++i)
+	{
+		for (int8_t d = -1; d <= 1; ++d) { targets.push_back(log.fixes[i].Time + d); }
+	}
+
+	FixRecord fix;
+	for (size_t t = 0; t < targets.size(); ++t)
+	{
+		const uint32_t Time = targets[t];
+		size_t expected = log.fixes.size();
+		for (size_t i = 0; i < log.fixes.size(); ++i)
+		{
+			if ((log.fixes[i].Time >= Time) && ((expected == log.fixes.size()) || (log.fixes[i].Time < log.fixes[expected].Time)))
+			{
+				expected = i;
+			}
+		}
+
+		const bool found = reader.seek(index.data(), index.size(), Time, fix);
+		if (found != (expected < log.fixes.size())) { return false; }
+		if (!found) { continue; }
+		if (!same(fix, log.fixes[expected])) { return false; }
+		for (size_t i = expected; i < min(expected + 3, log.fixes.size()); ++i)
+		{
+			if (!reader.next(fix) || !same(fix, log.fixes[i])) { return false; }
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	std::mt19937 rng(3);
+
+	// round trip, for a range of keyframe intervals
+	const uint8_t intervals[] = { 1, 2, 7, 60, 255 };
+	bool ok = true, cut_ok = true;
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		const Log log = random_log(rng, intervals[i], 2000);
+		ok &= round_trip(log);
+		if (i < 3) { cut_ok &= truncated(random_log(rng, intervals[i], 200)); }
+	}
+	check("round trip of random fixes, keyframe intervals 1, 2, 7, 60, 255", ok);
+	check("log cut off mid-record stops at the last whole record", cut_ok);
+
+	// the int32 extremes back to back, both ways
+	{
+		FixLogWriter writer;
+		Log log;
+		FixRecord fix = FixRecord();
+		const int32_t extremes[] = { INT32_MIN, INT32_MAX, INT32_MIN, 0, INT32_MAX, -1, INT32_MIN };
+		for (uint8_t i = 0; i < 7; ++i)
+		{
+			fix.Time = (i == 6) ? 0xFFFFFFFF : i;
+			fix.Lat = fix.Long = fix.Alt = fix.Knots = extremes[i];
+			log.write(writer, fix);
+		}
+		check("round trip of INT32_MIN <-> INT32_MAX deltas", round_trip(log));
+	}
+
+	// a log that starts mid-stream (e.g. the start of a ring buffer was overwritten)
+	{
+		const Log log = stepped_log(30, 0, 0, 1000);
+		FixLogReader reader(log.data.data() + log.ends[0], log.data.size() - log.ends[0]);
+		FixRecord fix;
+		check("log not starting with a keyframe decodes nothing", !reader.next(fix) && (reader.position() == 0));
+	}
+
+	// seek
+	check("seek, random monotonic log (keyframe interval 7)", seek_matches(random_log(rng, 7, 300)));
+	check("seek, 1Hz log", seek_matches(stepped_log(100, 0, 0, 100000)));
+	check("seek, time steps back 100s at record 50", seek_matches(stepped_log(100, 50, -100, 100000)));
+	check("seek, time steps back 5s mid keyframe interval", seek_matches(stepped_log(100, 55, -5, 100000)));
+	check("seek, time steps forward 1000s at record 50", seek_matches(stepped_log(100, 50, 1000, 100000)));
+	{
+		// logging started on a GGA before any RMC, so the first fixes are dated 06/01/80 (2080)
+		const uint32_t y2080 = to_seconds_since_2000<uint8_t>(0, 0, 0, 6, 1, 80);
+		const Log log = stepped_log(100, 5, 500000000 - y2080, y2080);
+		check("seek, log starting with fixes dated 2080", seek_matches(log));
+	}
+
+	// toFixRecord(), from the same sentences in either build
+	{
+		ATtinyGPS gps;
+		const char *sentences =
+			"$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+			"$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+		for (const char *c = sentences; *c != '\0'; ++c) { gps.parse(*c); }
+		FixRecord fix;
+		toFixRecord(gps, fix);
+
+		// ATtinyGPS negates N latitudes and E longitudes
+		const int32_t Lat = -480703800L, Long = -113100000L;
+#ifdef NO_FLOATS
+		const int32_t tolerance = FIXLOG_LATLONG_SCALE / LATLONG_DIVISOR + 1; // one step of the parser's fixed point
+		const char *name = "toFixRecord, NO_FLOATS build";
+#else
+		const int32_t tolerance = 25; // half a float step (2^-11) of a ddmm.mmmm below 8192
+		const char *name = "toFixRecord, float build";
+#endif
+		check(name, (fix.Time == to_seconds_since_2000<uint8_t>(12, 35, 19, 23, 3, 94)) &&
+			(abs(fix.Lat - Lat) <= tolerance) && (abs(fix.Long - Long) <= tolerance) &&
+			(fix.Alt == 54540) && (fix.Knots == 2240) && (fix.quality == 1) && (fix.satellites == 8));
+		printf("     %u,%d,%d,%d,%d,%u,%u\n", (unsigned)fix.Time, (int)fix.Lat, (int)fix.Long,
+			(int)fix.Alt, (int)fix.Knots, fix.quality, fix.satellites);
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/*
+Host side decoder for FixLog.h logs (Linux/macOS)
+
+Build : g++ -O2 -I../.. -o fixlog_dump fixlog_dump.cpp
+Usage : fixlog_dump <log file> [seconds since 2000]
+
+Prints every fix as CSV (Lat, Long are ddmm.mmmmm x 100000), starting from the first fix at or after the
+(optional) time. Exits with 1 if no fix could be decoded
+*/
+
+#include <FixLog.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage : %s <log file> [seconds since 2000]\n", argv[0]);
+		return 1;
+	}
+
+	const int fd = open(argv[1], O_RDONLY);
+	struct stat st;
+	if ((fd < 0) || (fstat(fd, &st) != 0))
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	if (st.st_size == 0)
+	{
+		fprintf(stderr, "can't decode the first record (the log is empty)\n");
+		close(fd);
+		return 1;
+	}
+
+	const uint8_t *data = (const uint8_t *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data == MAP_FAILED)
+	{
+		perror("mmap");
+		return 1;
+	}
+
+	FixLogReader log(data, st.st_size);
+	FixRecord fix;
+	bool found;
+
+	if (argc > 2)
+	{
+		std::vector<FixLogIndex> index(log.buildIndex(NULL, 0));
+		log.buildIndex(index.data(), index.size());
+		found = log.seek(index.data(), index.size(), strtoul(argv[2], NULL, 10), fix);
+	}
+	else
+	{
+		found = log.next(fix);
+	}
+
+	if (found)
+	{
+		printf("Time,Lat,Long,Alt,Knots,quality,satellites\n");
+		if (argc > 2) { log.next(fix); } // seek() leaves the reader on the fix it found
+		do
+		{
+			printf("%u,%d,%d,%d,%d,%u,%u\n", (unsigned)fix.Time, (int)fix.Lat, (int)fix.Long,
+				(int)fix.Alt, (int)fix.Knots, fix.quality, fix.satellites);
+		} while (log.next(fix));
+
+		if (log.position() < (size_t)st.st_size)
+		{
+			fprintf(stderr, "stopped at byte %u of %u (truncated or corrupt record)\n",
+				(unsigned)log.position(), (unsigned)st.st_size);
+		}
+	}
+	else if (argc > 2)
+	{
+		fprintf(stderr, "no fix at or after %s\n", argv[2]);
+	}
+	else
+	{
+		fprintf(stderr, "can't decode the first record (corrupt, or the log doesn't start with a keyframe)\n");
+	}
+
+	munmap((void *)data, st.st_size);
+	close(fd);
+	return found ? 0 : 1;
+}
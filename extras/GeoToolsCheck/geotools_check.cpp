@@ -0,0 +1,179 @@
+/*
+Host check of GeoTools.h against a double precision reference (Linux/macOS)
+
+Build : g++ -O2 -I../.. -I../HostShim -o geotools_check geotools_check.cpp
+Usage : geotools_check
+
+Asserts the error bounds documented at the top of GeoTools.h. Exits with 1 if any is exceeded
+*/
+
+// std headers first : the Arduino min/max macros break <random>
+#include <math.h>
+#include <stdio.h>
+#include <random>
+
+#include <GeoTools.h>
+
+static const double R_CM = 637100880.0; // mean earth radius, as used by GeoTools.h (11.1195 cm per udeg)
+static const double DEG = M_PI / 180;
+
+static double reference_cm(const int32_t lat1, const int32_t lon1, const int32_t lat2, const int32_t lon2)
+{
+	const double p1 = lat1 * 1e-6 * DEG, p2 = lat2 * 1e-6 * DEG;
+	const double dp = p2 - p1, dl = (lon2 - lon1) * 1e-6 * DEG;
+	const double a = sin(dp / 2) * sin(dp / 2) + cos(p1) * cos(p2) * sin(dl / 2) * sin(dl / 2);
+	return 2 * R_CM * atan2(sqrt(a), sqrt(1 - a));
+}
+
+static double reference_bearing(const int32_t lat1, const int32_t lon1, const int32_t lat2, const int32_t lon2)
+{
+	const double p1 = lat1 * 1e-6 * DEG, p2 = lat2 * 1e-6 * DEG, dl = (lon2 - lon1) * 1e-6 * DEG;
+	const double b = atan2(sin(dl) * cos(p2), cos(p1) * sin(p2) - sin(p1) * cos(p2) * cos(dl)) / DEG;
+	return fmod(b + 360, 360);
+}
+
+static int failures = 0;
+
+static void check(const char *name, const double measured, const double bound, const char *unit)
+{
+	const bool ok = measured < bound;
+	printf("%-4s %-52s %10.4f %-3s (bound %g)\n", ok ? "ok" : "FAIL", name, measured, unit, bound);
+	failures += !ok;
+}
+
+static int32_t to_udeg(const double deg) { return (int32_t)llround(deg * 1e6); }
+
+// random pairs with |lat| < 80, whose reference distance is in [lo_cm, hi_cm). Returns the worst error
+static void distance_band(std::mt19937 &rng, const char *name, const double lo_cm, const double hi_cm,
+	const double rel_bound, const double abs_bound_cm)
+{
+	std::uniform_real_distribution<double> u(-1, 1);
+	double worst_rel = 0, worst_abs = 0;
+	const double span = hi_cm / (R_CM * DEG); // degrees
+	for (int n = 0; n < 500000;)
+	{
+		const double lat1 = u(rng) * 80, lon1 = u(rng) * 180;
+		double lat2, lon2;
+		if (hi_cm > 1.9e9) // near antipodal
+		{
+			lat2 = -lat1 + u(rng) * 5; lon2 = lon1 + 180 + u(rng) * 5;
+		}
+		else
+		{
+			const double f = (u(rng) + 1) / 2;
+			lat2 = lat1 + u(rng) * span * f; lon2 = lon1 + u(rng) * span * f / cos(lat1 * DEG);
+		}
+		if (fabs(lat2) >= 80) { continue; }
+		if (lon2 > 180) { lon2 -= 360; }
+		if (lon2 < -180) { lon2 += 360; }
+
+		const int32_t a1 = to_udeg(lat1), o1 = to_udeg(lon1), a2 = to_udeg(lat2), o2 = to_udeg(lon2);
+		const double ref = reference_cm(a1, o1, a2, o2);
+		if ((ref < lo_cm) || (ref >= hi_cm)) { continue; }
+		++n;
+
+		const double err = fabs(distance_cm(a1, o1, a2, o2) - ref);
+		worst_abs = fmax(worst_abs, err);
+		worst_rel = fmax(worst_rel, err / ref);
+	}
+	char label[64];
+	if (rel_bound > 0)
+	{
+		snprintf(label, sizeof(label), "distance %s, relative", name);
+		check(label, worst_rel * 100, rel_bound, "%");
+	}
+	if (abs_bound_cm > 0)
+	{
+		snprintf(label, sizeof(label), "distance %s, absolute", name);
+		check(label, worst_abs, abs_bound_cm, "cm");
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(1);
+
+	// trig
+	double worst = 0;
+	for (int32_t a = -400000000; a <= 400000000; a += 997)
+	{
+		worst = fmax(worst, fabs(cos_udeg(a) / 32768.0 - cos(a * 1e-6 * DEG)));
+	}
+	check("cos_udeg, absolute (Q15 counts)", worst * 32768, 1.1, "");
+	worst = 0;
+	for (int32_t a = 1000; a <= 10000000; a += 997)
+	{
+		worst = fmax(worst, fabs(sin_q30(a) / 1073741824.0 / sin(a * 1e-6 * DEG) - 1));
+	}
+	check("sin_q30 under 10 deg, relative", worst * 100, 0.002, "%");
+
+	// isqrt
+	bool isqrt_ok = true;
+	for (uint32_t n = 0; n < 5000000; n += 7) { const uint64_t r = isqrt(n); isqrt_ok &= (r * r <= n) & ((r + 1) * (r + 1) > n); }
+	for (uint32_t n = 0xFFFFFFFF; n > 0xFFF00000; n -= 1013) { const uint64_t r = isqrt(n); isqrt_ok &= (r * r <= n) & ((r + 1) * (r + 1) > n); }
+	check("isqrt, wrong results", !isqrt_ok, 0.5, "");
+
+	// ddmm.mmmm -> udeg, for the parser's actual LATLONG_DIVISOR (16960), float builds (1000) and 1e6
+	const uint32_t scales[] = { 1000, 16960, 100000, 1000000 };
+	worst = 0;
+	for (uint8_t i = 0; i < 4; ++i)
+	{
+		for (int32_t ddmm = 0; ddmm < 18000; ddmm += 37)
+		{
+			if (ddmm % 100 >= 60) { continue; }
+			const double frac = (ddmm % 997) / 997.0;
+			if ((double)ddmm * scales[i] > 2.1e9) { break; }
+			const int32_t v = (int32_t)((ddmm + frac) * scales[i]);
+			const double ref = (ddmm / 100 + (ddmm % 100 + (double)(v % scales[i]) / scales[i]) / 60) * 1e6;
+			worst = fmax(worst, fabs(ddmm_to_udeg(v, scales[i]) - ref));
+			worst = fmax(worst, fabs(ddmm_to_udeg(-v, scales[i]) + ref));
+		}
+	}
+	check("ddmm_to_udeg, absolute", worst, 2, "udeg");
+
+	// distance, by band
+	distance_band(rng, "legs < 20m", 0, 2000, 0, 1);
+	distance_band(rng, "legs 20m - 10km", 2000, 1e6, 0.03, 0);
+	distance_band(rng, "legs 10km - 200km", 1e6, 2e7, 0.03, 0);
+	distance_band(rng, "legs 200km - 1000km", 2e7, 1e8, 0.03, 0);
+	distance_band(rng, "legs 1000km - 19000km", 1e8, 1.9e9, 0.03, 0);
+	distance_band(rng, "legs > 19000km (near antipodal)", 1.9e9, 2.1e9, 0, 50000);
+
+	double equator = 0;
+	for (int32_t lon = 170000000; lon <= 180000000; lon += 100000)
+	{
+		equator = fmax(equator, fabs(distance_cm(0, 0, 0, lon) - reference_cm(0, 0, 0, lon)));
+	}
+	check("distance equator 0 -> 170..180 deg, absolute", equator, 50000, "cm");
+
+	// bearing, legs < 10km
+	std::uniform_real_distribution<double> u(-1, 1);
+	worst = 0;
+	for (int n = 0; n < 500000; ++n)
+	{
+		const double lat1 = u(rng) * 80, lon1 = u(rng) * 180;
+		const double f = 0.09 * pow(10, -2.5 * (u(rng) + 1)); // log uniform, ~0.1m -> 10km
+		const int32_t a1 = to_udeg(lat1), o1 = to_udeg(lon1);
+		const int32_t a2 = to_udeg(lat1 + u(rng) * f), o2 = to_udeg(lon1 + u(rng) * f / cos(lat1 * DEG));
+		if ((reference_cm(a1, o1, a2, o2) == 0) || (reference_cm(a1, o1, a2, o2) >= 1e6)) { --n; continue; }
+		double err = fabs(bearing_cdeg(a1, o1, a2, o2) / 100.0 - reference_bearing(a1, o1, a2, o2));
+		worst = fmax(worst, fmin(err, 360 - err));
+	}
+	check("bearing legs < 10km, absolute", worst, 0.03, "deg");
+
+	// odometer : an hour at ~3m/s, summed leg by leg
+	Odometer odometer(100);
+	int32_t lat = -33800000, lon = 151200000;
+	double total = 0;
+	odometer.update(lat, lon, 500000000);
+	for (int i = 1; i <= 3600; ++i)
+	{
+		const int32_t lat2 = lat + 25 + (i % 3), lon2 = lon + 10;
+		total += reference_cm(lat, lon, lat2, lon2);
+		lat = lat2; lon = lon2;
+		odometer.update(lat, lon, 500000000 + i);
+	}
+	check("odometer over 1 hour of 3m legs, relative", fabs(odometer.Distance - total) / total * 100, 0.05, "%");
+
+	return (failures == 0) ? 0 : 1;
+}
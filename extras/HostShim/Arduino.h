@@ -0,0 +1,24 @@
+// Just enough of the Arduino core to build the library headers on a host (Linux/macOS) for the extras/ checks
+#ifndef HostShim_Arduino_h
+#define HostShim_Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean;
+
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+#define F(s) (s)
+
+// millis() reads a clock the check drives itself : host_millis = ...
+static uint32_t host_millis = 0;
+static inline uint32_t millis() { return host_millis; }
+
+#endif
@@ -0,0 +1,17 @@
+// Print is only needed for ATtinyGPS::setup(Print &), so it writes nowhere
+#ifndef HostShim_Print_h
+#define HostShim_Print_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class Print
+{
+public:
+	size_t write(uint8_t) { return 1; }
+	size_t print(const char *s) { return strlen(s); }
+	size_t println(const char *s = "") { return strlen(s) + 2; }
+};
+
+#endif
@@ -0,0 +1,11 @@
+// PROGMEM is plain memory on the host
+#ifndef HostShim_pgmspace_h
+#define HostShim_pgmspace_h
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte_near(p) (*(const uint8_t *)(p))
+#define pgm_read_word_near(p) (*(const uint16_t *)(p))
+
+#endif